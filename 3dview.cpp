@@ -7,18 +7,18 @@
 /* STD */
 
 #include <iostream>
-#include <fstream>
 
 using namespace std;
 
 /* Custom Imports */
 
-#include "custom/gl_load.cpp"    // Load OpenGL function pointers
-#include "custom/gl_debug.cpp"   // Enable OpenGL errors/warnings
-#include "custom/gl_shader.cpp"  // Compile/link OpenGL shaders
-#include "custom/model.cpp"      // Model loading and utils
-#include "custom/gl_helpers.cpp" // OpenGL helpers
-#include "custom/glfw.cpp"       // Handle windowing operations and keyboard/mouse events
+#include "custom/gl_load.cpp"      // Load OpenGL function pointers
+#include "custom/gl_debug.cpp"     // Enable OpenGL errors/warnings
+#include "custom/gl_shader.cpp"    // Compile/link OpenGL shaders
+#include "custom/model.cpp"        // Model loading and utils
+#include "custom/gl_helpers.cpp"   // OpenGL helpers
+#include "custom/glfw.cpp"         // Handle windowing operations and keyboard/mouse events
+#include "custom/model_import.cpp" // Import OBJ/PLY models
 
 /* External */
 
@@ -96,11 +96,11 @@ int main() {
 	/* Load and use program */
 
 	auto program = custom::gl_make_program(V_SHADER, F_SHADER);
-	program.use();
+	glUseProgram(program);
 
 	/* Load Model */
 
-	auto model = custom::model_tlst_load(MODEL_IN);
+	auto model = custom::model_load(MODEL_IN);
 
 	glGenVertexArrays(1, &model.VAO);  
 	glGenBuffers(1, &model.VBO); 
@@ -145,7 +145,7 @@ int main() {
 
 	/* Send Transformation Matrix To GPU */
 
-	auto transform_loc = glGetUniformLocation(program.id, "transform");
+	auto transform_loc = glGetUniformLocation(program, "transform");
 	glUniformMatrix4fv(transform_loc, 1, GL_FALSE, glm::value_ptr(transform));
 
 	/* Draw Model */
@@ -158,24 +158,7 @@ int main() {
 
 	/* Save Model (Optionally) */
 
-	if (MODEL_SAVE) {
-		ofstream new_model;
-		new_model.open(MODEL_OUT);
-
-		auto v = model.vertices;
-		auto t = model.triangles;
-		new_model << model.vertex_count << " " << model.triangle_count << endl;
-		new_model << endl;
-		for (auto i = (size_t) 0; i < v.size() - 2; i += 3) {
-			auto old_v = glm::vec4(v[i], v[i + 1], v[i + 2], 1.0f);
-			auto new_v = transform * old_v;
-			new_model << new_v.x << " " << new_v.y << " " << new_v.z << endl;
-		}
-		new_model << endl;
-		for (auto i = (size_t) 0; i < t.size() - 2; i += 3) {
-			new_model << t[i] << " " << t[i + 1] << " " << t[i + 2] << endl;
-		}
-	}
+	if (MODEL_SAVE) custom::model_tlst_save(model, MODEL_OUT, transform);
 
 	/* Waiting Loop */
 
@@ -0,0 +1,321 @@
+/******************************************************************************/
+
+/***********/
+/* Imports */
+/***********/
+
+/* STD */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* Custom Imports */
+
+#include "custom/gl_load.cpp"    // Load OpenGL function pointers
+#include "custom/model.cpp"      // Model loading and utils
+#include "custom/gl_helpers.cpp" // OpenGL helpers
+#include "custom/glfw.cpp"       // Handle windowing operations and keyboard/mouse events
+#include "custom/physics.cpp"    // Bouncing object simulation
+
+/* External */
+
+// GLM
+// OpenGL math library
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+/******************************************************************************/
+
+/*************/
+/* Constants */
+/*************/
+
+// OpenGL version
+#define OPEN_GL_MAJOR_VERSION 3
+#define OPEN_GL_MINOR_VERSION 3
+
+// Headless window constants
+#define WINDOW_WIDTH  64
+#define WINDOW_HEIGHT 64
+#define WINDOW_TITLE  "Benchmark"
+
+// Measurement constants
+// Each case runs for at least BENCH_MIN_TIME seconds and BENCH_MIN_RUNS runs
+#define BENCH_MIN_TIME 0.5
+#define BENCH_MIN_RUNS 3
+
+// Synthetic mesh constants
+// Grid of SYNTHETIC_GRID x SYNTHETIC_GRID vertices, about 2M triangles
+#define SYNTHETIC_GRID 1000
+
+// Input/Output Constants
+#define BENCH_OUT       "bench.json"
+#define BENCH_BASELINE  "bench_baseline.json"
+#define BENCH_TMP_MODEL "bench_model.tlst.tmp"
+
+// Fail if a case gets slower than its baseline by more than this fraction
+#define BENCH_THRESHOLD 0.20
+
+/******************************************************************************/
+
+/********************/
+/* Global Variables */
+/********************/
+
+// Models to benchmark, loaded from files
+vector<pair<string, const char*>> g_model_files = {
+	{ "sphere", "models/sphere.tlst" },
+	{ "cube",   "models/cube.tlst"   },
+	{ "bunny",  "models/bunny.tlst"  }
+};
+
+// Number of simulated objects
+vector<long> g_object_counts = { 1, 1000, 1000000 };
+
+// Results in nanoseconds per operation
+vector<pair<string, double>> g_results;
+
+// Keeps results alive so the compiler cannot drop the work
+volatile float g_sink;
+
+/******************************************************************************/
+
+/*************************/
+/* Function Declarations */
+/*************************/
+
+custom::Model make_synthetic_model(int grid);
+double measure(const function<void()>& fn);
+void record(const string& name, double ns, const char* unit);
+void write_results();
+bool compare_baseline();
+
+/******************************************************************************/
+
+int main() {
+	/* Initialize headless OpenGL context */
+
+	custom::glfw_init(OPEN_GL_MAJOR_VERSION, OPEN_GL_MINOR_VERSION);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	auto window = custom::glfw_create_window(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_TITLE);
+	glfwMakeContextCurrent(window);
+
+	custom::gl_load();
+
+	/* Load Models */
+
+	vector<pair<string, custom::Model>> models;
+	for (auto& file : g_model_files) models.push_back({ file.first, custom::model_tlst_load(file.second) });
+	models.push_back({ "synthetic", make_synthetic_model(SYNTHETIC_GRID) });
+
+	GLuint VAO, VBO, EBO;
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
+	glBindVertexArray(VAO);
+
+	auto identity = glm::mat4(1.0f);
+
+	for (auto& entry : models) {
+		auto& name  = entry.first;
+		auto& model = entry.second;
+
+		/* Loading (TLST parsing) */
+
+		// Saved first, so every model is loaded from the same kind of file
+		custom::model_tlst_save(model, BENCH_TMP_MODEL, identity);
+		record("load/" + name, measure([] {
+			auto loaded = custom::model_tlst_load(BENCH_TMP_MODEL);
+			g_sink = loaded.lowest_vertex;
+		}), "run");
+
+		/* Lowest Vertex */
+
+		record("lowest_vertex/" + name, measure([&model] {
+			g_sink = custom::model_lowest_vertex(model.vertices);
+		}), "run");
+
+		/* Upload */
+
+		record("upload/" + name, measure([&model, VBO, EBO] {
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			custom::glBufferDataV(GL_ARRAY_BUFFER, model.vertices, GL_STATIC_DRAW);
+
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+			custom::glBufferDataV(GL_ELEMENT_ARRAY_BUFFER, model.triangles, GL_STATIC_DRAW);
+
+			// Wait for the copy to finish
+			glFinish();
+		}), "run");
+
+		/* Transform and Export (3dview) */
+
+		auto transform = glm::scale(identity, glm::vec3(0.5f, 0.5f, 0.5f));
+		transform      = glm::rotate(transform, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		record("export/" + name, measure([&model, transform] {
+			custom::model_tlst_save(model, BENCH_TMP_MODEL, transform);
+		}), "run");
+	}
+
+	remove(BENCH_TMP_MODEL);
+
+	/* Simulation Update */
+
+	// Independent of the model, the lowest vertex only offsets the ground
+	for (auto count : g_object_counts) {
+		auto bodies = vector<custom::Body>(count);
+		for (auto& body : bodies) custom::body_reset(body);
+
+		auto ns = measure([&bodies] {
+			auto sum = 0.0f;
+			for (auto& body : bodies) sum += custom::body_step(body, 0.0f)[3][1];
+			g_sink = sum;
+		});
+		record("update/" + to_string(count), ns / count, "object");
+	}
+
+	/* Results */
+
+	write_results();
+	auto passed = compare_baseline();
+
+	/* Terminate */
+
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteVertexArrays(1, &VAO);
+
+	glfwTerminate();
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/******************************************************************************/
+
+// Grid mesh with a wavy surface, large enough to stress every path
+custom::Model make_synthetic_model(int grid) {
+	auto model = custom::Model(grid * grid, 2 * (grid - 1) * (grid - 1));
+	model.filename = "synthetic";
+
+	auto& v = model.vertices;
+	for (auto z = 0; z < grid; z++) {
+		for (auto x = 0; x < grid; x++) {
+			auto i = (size_t) (z * grid + x) * VERTEX_3D_COMPONENTS;
+			auto fx = 2.0f * x / (grid - 1) - 1.0f;
+			auto fz = 2.0f * z / (grid - 1) - 1.0f;
+			v[i]     = fx;
+			v[i + 1] = 0.1f * sinf(10.0f * fx) * cosf(10.0f * fz);
+			v[i + 2] = fz;
+		}
+	}
+
+	auto& t = model.triangles;
+	auto j = (size_t) 0;
+	for (auto z = 0; z < grid - 1; z++) {
+		for (auto x = 0; x < grid - 1; x++) {
+			auto a = z * grid + x;
+			auto b = a + grid;
+			t[j++] = a; t[j++] = b;     t[j++] = a + 1;
+			t[j++] = b; t[j++] = b + 1; t[j++] = a + 1;
+		}
+	}
+
+	model.lowest_vertex = custom::model_lowest_vertex(v);
+
+	return model;
+}
+
+// Average nanoseconds per call of fn
+// Calls are batched so that fast functions are not dominated by the clock
+double measure(const function<void()>& fn) {
+	using clock = chrono::steady_clock;
+
+	// Warm up caches and driver
+	fn();
+
+	auto runs  = (long) 0;
+	auto batch = (long) 1;
+	auto start = clock::now();
+	auto elapsed = 0.0;
+
+	while (elapsed < BENCH_MIN_TIME || runs < BENCH_MIN_RUNS) {
+		for (auto i = 0; i < batch; i++) fn();
+		runs += batch;
+
+		elapsed = chrono::duration<double>(clock::now() - start).count();
+		if (elapsed < BENCH_MIN_TIME / 100) batch *= 2;
+	}
+
+	return elapsed * 1e9 / runs;
+}
+
+// Store and print one result
+void record(const string& name, double ns, const char* unit) {
+	g_results.push_back({ name, ns });
+
+	if      (ns >= 1e6) printf("%-28s %12.3f ms/%s\n", name.c_str(), ns / 1e6, unit);
+	else if (ns >= 1e3) printf("%-28s %12.3f us/%s\n", name.c_str(), ns / 1e3, unit);
+	else                printf("%-28s %12.3f ns/%s\n", name.c_str(), ns,       unit);
+}
+
+// Write results as JSON, one result per line
+void write_results() {
+	ofstream out;
+	out.open(BENCH_OUT);
+
+	out << "{" << endl;
+	out << "  \"results\": [" << endl;
+	for (auto i = (size_t) 0; i < g_results.size(); i++) {
+		out << "    { \"name\": \"" << g_results[i].first << "\", \"ns\": " << fixed << g_results[i].second << " }";
+		out << (i + 1 < g_results.size() ? "," : "") << endl;
+	}
+	out << "  ]" << endl;
+	out << "}" << endl;
+}
+
+// Compare results with a baseline written by an earlier run
+// Returns false if any case regressed past BENCH_THRESHOLD
+bool compare_baseline() {
+	ifstream file;
+	file.open(BENCH_BASELINE);
+
+	if (!file) {
+		cout << "No " << BENCH_BASELINE << ", skipping regression check." << endl;
+		return true;
+	}
+
+	map<string, double> baseline;
+	string line;
+	while (getline(file, line)) {
+		char name[128];
+		double ns;
+		if (sscanf(line.c_str(), " { \"name\": \"%127[^\"]\", \"ns\": %lf", name, &ns) == 2) baseline[name] = ns;
+	}
+
+	auto passed = true;
+	for (auto& result : g_results) {
+		auto base = baseline.find(result.first);
+		if (base == baseline.end()) continue;
+
+		auto ratio = result.second / base->second;
+		if (ratio > 1.0 + BENCH_THRESHOLD) {
+			printf("REGRESSION %-28s %6.2fx baseline\n", result.first.c_str(), ratio);
+			passed = false;
+		}
+	}
+
+	if (passed) cout << "No regressions against " << BENCH_BASELINE << "." << endl;
+
+	return passed;
+}
+
+/******************************************************************************/
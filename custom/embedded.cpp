@@ -0,0 +1,77 @@
+// Compile-Time Embedded Models / Shaders
+
+#ifndef __CUSTOM_EMBEDDED__
+#define __CUSTOM_EMBEDDED__
+
+#include <cstring>
+
+#include "model.cpp"
+
+namespace custom {
+	using namespace std;
+
+	// Model parsed ahead of time by embed.out
+	struct EmbeddedModel {
+		const char* filename;
+
+		GLint vertex_count;
+		GLint triangle_count;
+
+		const GLfloat* vertices;
+		const GLint*   triangles;
+
+		GLfloat lowest_vertex;
+	};
+
+	// Shader source copied ahead of time by embed.out
+	struct EmbeddedShader {
+		const char*   filename;
+		const GLchar* code;
+	};
+}
+
+// Generated by embed.out
+// Defines embedded_models and embedded_shaders
+#include "embedded_assets.cpp"
+
+namespace custom {
+	using namespace std;
+
+	// Find an embedded model by its original file name
+	const EmbeddedModel* embedded_model_find(const char* filename) {
+		for (auto& asset : embedded_models) {
+			if (strcmp(asset.filename, filename) == 0) return &asset;
+		}
+		return NULL;
+	}
+
+	// Find an embedded shader by its original file name
+	const GLchar* embedded_shader_find(const char* filename) {
+		for (auto& asset : embedded_shaders) {
+			if (strcmp(asset.filename, filename) == 0) return asset.code;
+		}
+		return NULL;
+	}
+
+	// Load a 3D model that was embedded at compile time
+	// No file I/O or parsing, vertex data stays in read-only memory
+	Model model_embedded_load(const char* filename) {
+		auto asset = embedded_model_find(filename);
+
+		if (asset == NULL) {
+			cerr << "Model " << filename << " is not embedded." << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		// No CPU copies, buffers are filled from the embedded arrays
+		auto model = Model(0, 0);
+		model.filename       = filename;
+		model.vertex_count   = asset->vertex_count;
+		model.triangle_count = asset->triangle_count;
+		model.lowest_vertex  = asset->lowest_vertex;
+
+		return model;
+	}
+}
+
+#endif // __CUSTOM_EMBEDDED__
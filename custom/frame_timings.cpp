@@ -0,0 +1,56 @@
+// Per-Frame Timings
+
+#ifndef __CUSTOM_FRAME_TIMINGS__
+#define __CUSTOM_FRAME_TIMINGS__
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace custom {
+	using namespace std;
+
+	// Wall-clock duration of every frame
+	struct FrameTimings {
+		vector<double> ms;
+
+		chrono::steady_clock::time_point last;
+		bool started = false;
+	};
+
+	// Call once per frame, the first call only starts the clock
+	void frame_timings_tick(FrameTimings& timings) {
+		auto now = chrono::steady_clock::now();
+		if (timings.started) timings.ms.push_back(chrono::duration<double, milli>(now - timings.last).count());
+		timings.last    = now;
+		timings.started = true;
+	}
+
+	// Write one "frame,ms" line per frame and print a summary
+	void frame_timings_report(const FrameTimings& timings, const char* filename) {
+		ofstream out;
+		out.open(filename);
+		out << "frame,ms" << endl;
+		for (auto i = (size_t) 0; i < timings.ms.size(); i++) out << i << "," << timings.ms[i] << endl;
+
+		if (timings.ms.empty()) return;
+
+		auto sorted = timings.ms;
+		sort(sorted.begin(), sorted.end());
+		auto percentile = [&sorted](double p) { return sorted[(size_t) (p * (sorted.size() - 1))]; };
+
+		auto total = 0.0;
+		for (auto ms : sorted) total += ms;
+
+		cout << "Frame Timings (" << sorted.size() << " frames, written to " << filename << "):" << endl;
+		cout << "  + Mean -> " << total / sorted.size() << " ms" << endl;
+		cout << "  + P50  -> " << percentile(0.50)      << " ms" << endl;
+		cout << "  + P95  -> " << percentile(0.95)      << " ms" << endl;
+		cout << "  + P99  -> " << percentile(0.99)      << " ms" << endl;
+		cout << "  + Max  -> " << sorted.back()         << " ms" << endl;
+	}
+}
+
+#endif // __CUSTOM_FRAME_TIMINGS__
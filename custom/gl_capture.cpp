@@ -0,0 +1,193 @@
+// Asynchronous Frame Capture
+
+#ifndef __CUSTOM_GL_CAPTURE__
+#define __CUSTOM_GL_CAPTURE__
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "png.cpp"
+
+// Capture modes
+#define CAPTURE_OFF 0
+#define CAPTURE_RAW 1 // All frames in one file, 8-bit RGBA, top row first
+#define CAPTURE_PNG 2 // One PNG file per frame
+
+// Frames in flight between glReadPixels and glMapBuffer
+#define CAPTURE_PBO_COUNT 3
+
+// Frames waiting for the writer thread before the render loop blocks
+#define CAPTURE_QUEUE_MAX 8
+
+namespace custom {
+	using namespace std;
+
+	// Frame read back from the GPU, waiting to be written
+	struct CapturedFrame {
+		long index;
+		vector<unsigned char> pixels;
+	};
+
+	// Ring of pixel buffer objects and background writer
+	struct Capture {
+		int mode;
+		int width;
+		int height;
+		string out;
+
+		// Ring of PBOs, a slot is in use while its fence is set
+		GLuint pbos[CAPTURE_PBO_COUNT];
+		GLsync fences[CAPTURE_PBO_COUNT];
+		long   indices[CAPTURE_PBO_COUNT];
+		long   next;
+
+		// Writer thread queue
+		thread                writer;
+		mutex                 lock;
+		condition_variable    changed;
+		deque<CapturedFrame>  queue;
+		bool                  done;
+	};
+
+	// Write frames from the queue until capture stops
+	void gl_capture_writer(Capture* capture) {
+		auto row_size = (size_t) capture->width * 4;
+		auto row      = vector<unsigned char>(row_size);
+
+		FILE* raw = NULL;
+		if (capture->mode == CAPTURE_RAW) {
+			raw = fopen(capture->out.c_str(), "wb");
+			if (raw == NULL) cerr << "Failed to open " << capture->out << "." << endl;
+		}
+
+		while (true) {
+			unique_lock<mutex> guard(capture->lock);
+			capture->changed.wait(guard, [capture] { return capture->done || !capture->queue.empty(); });
+			if (capture->queue.empty()) break;
+
+			auto frame = move(capture->queue.front());
+			capture->queue.pop_front();
+			guard.unlock();
+			capture->changed.notify_all();
+
+			// OpenGL reads bottom row first
+			auto& p = frame.pixels;
+			for (auto y = 0; y < capture->height / 2; y++) {
+				auto top    = &p[y * row_size];
+				auto bottom = &p[(capture->height - 1 - y) * row_size];
+				memcpy(&row.front(), top, row_size);
+				memcpy(top, bottom, row_size);
+				memcpy(bottom, &row.front(), row_size);
+			}
+
+			if (capture->mode == CAPTURE_RAW) {
+				if (raw != NULL) fwrite(&p.front(), 1, p.size(), raw);
+			} else {
+				char filename[32];
+				snprintf(filename, sizeof(filename), "_%06ld.png", frame.index);
+				auto path = capture->out + filename;
+				if (!png_write(path.c_str(), &p.front(), capture->width, capture->height)) {
+					cerr << "Failed to write " << path << "." << endl;
+				}
+			}
+		}
+
+		if (raw != NULL) fclose(raw);
+	}
+
+	// Map a finished PBO and hand its pixels to the writer thread
+	void gl_capture_collect(Capture* capture, int slot) {
+		// Usually signaled already, the read was issued frames ago
+		glClientWaitSync(capture->fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		glDeleteSync(capture->fences[slot]);
+		capture->fences[slot] = 0;
+
+		auto size  = (size_t) capture->width * capture->height * 4;
+		auto frame = CapturedFrame { capture->indices[slot], vector<unsigned char>(size) };
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, capture->pbos[slot]);
+		auto data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+		if (data != NULL) {
+			memcpy(&frame.pixels.front(), data, size);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		// Block only if the writer fell far behind
+		unique_lock<mutex> guard(capture->lock);
+		capture->changed.wait(guard, [capture] { return capture->queue.size() < CAPTURE_QUEUE_MAX; });
+		capture->queue.push_back(move(frame));
+		guard.unlock();
+		capture->changed.notify_all();
+	}
+
+	// Start capturing frames of the given size
+	// RAW writes to out, PNG writes to out_000000.png, out_000001.png, ...
+	Capture* gl_capture_start(int mode, int width, int height, const char* out) {
+		auto capture = new Capture();
+		capture->mode   = mode;
+		capture->width  = width;
+		capture->height = height;
+		capture->out    = out;
+		capture->next   = 0;
+		capture->done   = false;
+
+		glGenBuffers(CAPTURE_PBO_COUNT, capture->pbos);
+		for (auto i = 0; i < CAPTURE_PBO_COUNT; i++) {
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, capture->pbos[i]);
+			glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) width * height * 4, NULL, GL_STREAM_READ);
+			capture->fences[i] = 0;
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		capture->writer = thread(gl_capture_writer, capture);
+
+		return capture;
+	}
+
+	// Queue a read of the current back buffer
+	// Call after drawing and before swapping buffers
+	void gl_capture_frame(Capture* capture) {
+		auto slot = (int) (capture->next % CAPTURE_PBO_COUNT);
+
+		// Slot still holds a frame from CAPTURE_PBO_COUNT frames ago
+		if (capture->fences[slot] != 0) gl_capture_collect(capture, slot);
+
+		// Asynchronous: returns before the GPU copies the pixels
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, capture->pbos[slot]);
+		glReadPixels(0, 0, capture->width, capture->height, GL_RGBA, GL_UNSIGNED_BYTE, (void*) 0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		capture->fences[slot]  = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		capture->indices[slot] = capture->next;
+		capture->next++;
+	}
+
+	// Collect frames still in flight, wait for the writer and free resources
+	void gl_capture_stop(Capture* capture) {
+		for (auto i = 0; i < CAPTURE_PBO_COUNT; i++) {
+			auto slot = (int) ((capture->next + i) % CAPTURE_PBO_COUNT);
+			if (capture->fences[slot] != 0) gl_capture_collect(capture, slot);
+		}
+
+		{
+			lock_guard<mutex> guard(capture->lock);
+			capture->done = true;
+		}
+		capture->changed.notify_all();
+		capture->writer.join();
+
+		glDeleteBuffers(CAPTURE_PBO_COUNT, capture->pbos);
+
+		delete capture;
+	}
+}
+
+#endif // __CUSTOM_GL_CAPTURE__
@@ -3,12 +3,191 @@
 #ifndef __CUSTOM_GL_DEBUG__
 #define __CUSTOM_GL_DEBUG__
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <thread>
+
+// Messages buffered between the driver callback and the logger thread
+// Must be a power of two
+#define GL_DEBUG_RING_SIZE 1024
+
+// Longer messages are truncated
+#define GL_DEBUG_MESSAGE_SIZE 240
+
+// Maximum number of ignored message IDs
+#define GL_DEBUG_IGNORE_MAX 32
+
+// Marks an unused ignored ID entry
+#define GL_DEBUG_ID_NONE 0xFFFFFFFFu
+
+// Distinct messages (source, type, ID) whose repeats are counted
+// Must be a power of two
+#define GL_DEBUG_REPEAT_SLOTS 256
+
+// How often the logger thread prints new messages
+#define GL_DEBUG_DRAIN_MS 50
 
 namespace custom {
 	using namespace std;
 
+	// Repeat counter for one distinct message
+	struct DebugRepeat {
+		atomic<uint64_t> key;     // Hash of source, type, ID and text, 0 while unused
+		GLuint           id;      // Set by the thread that claimed the slot
+		atomic<size_t>   count;   // Repeats not printed yet
+		atomic<bool>     dropped; // First copy did not fit in the ring
+		bool             printed; // First copy was printed, logger thread only
+	};
+
+	// Compact copy of one debug message
+	struct DebugRecord {
+		atomic<size_t> sequence;
+
+		GLenum source;
+		GLenum type;
+		GLuint id;
+		GLenum severity;
+
+		DebugRepeat* repeat;
+
+		char message[GL_DEBUG_MESSAGE_SIZE];
+	};
+
+	// Lock-free multi-producer ring buffer and its logger thread
+	// Slot sequence numbers tell producers and the consumer whose turn it is
+	struct DebugLog {
+		DebugRecord ring[GL_DEBUG_RING_SIZE];
+
+		atomic<size_t> head;  // Next slot to write
+		size_t         tail;  // Next slot to read, logger thread only
+
+		atomic<size_t> dropped;
+
+		// Repeats are counted here instead of taking ring slots
+		DebugRepeat repeats[GL_DEBUG_REPEAT_SLOTS];
+
+		// Runtime filters
+		atomic<int>    min_severity;
+		atomic<GLuint> ignored[GL_DEBUG_IGNORE_MAX];
+
+		thread       logger;
+		atomic<bool> running;
+
+		DebugLog() : head(0), tail(0), dropped(0), min_severity(0), running(false) {
+			for (auto i = (size_t) 0; i < GL_DEBUG_RING_SIZE; i++) ring[i].sequence = i;
+			for (auto& id : ignored) id = GL_DEBUG_ID_NONE;
+			for (auto& repeat : repeats) {
+				repeat.key     = 0;
+				repeat.id      = 0;
+				repeat.count   = 0;
+				repeat.dropped = false;
+				repeat.printed = false;
+			}
+
+			// Non-significant error/warning codes
+			ignored[0] = 131169;
+			ignored[1] = 131185;
+			ignored[2] = 131218;
+			ignored[3] = 131204;
+		}
+
+		/* Destructor */
+		~DebugLog() {
+			running = false;
+			if (logger.joinable()) logger.join();
+		}
+	};
+
+	DebugLog g_gl_debug_log;
+
+	// Severity as a number, higher is more severe
+	int gl_debug_severity_rank(GLenum severity) {
+		switch (severity) {
+			case GL_DEBUG_SEVERITY_HIGH:   return 3;
+			case GL_DEBUG_SEVERITY_MEDIUM: return 2;
+			case GL_DEBUG_SEVERITY_LOW:    return 1;
+			default:                       return 0;
+		}
+	}
+
+	const char* gl_debug_type_txt(GLenum type) {
+		switch (type) {
+			case GL_DEBUG_TYPE_ERROR:               return "Error";
+			case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "Deprecated Behaviour";
+			case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "Undefined Behaviour";
+			case GL_DEBUG_TYPE_PORTABILITY:         return "Portability";
+			case GL_DEBUG_TYPE_PERFORMANCE:         return "Performance";
+			case GL_DEBUG_TYPE_MARKER:              return "Marker";
+			case GL_DEBUG_TYPE_PUSH_GROUP:          return "Push Group";
+			case GL_DEBUG_TYPE_POP_GROUP:           return "Pop Group";
+			case GL_DEBUG_TYPE_OTHER:               return "Other";
+		}
+		return "";
+	}
+
+	const char* gl_debug_source_txt(GLenum source) {
+		switch (source) {
+			case GL_DEBUG_SOURCE_API:             return "API";
+			case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   return "Window System";
+			case GL_DEBUG_SOURCE_SHADER_COMPILER: return "Shader Compiler";
+			case GL_DEBUG_SOURCE_THIRD_PARTY:     return "Third Party";
+			case GL_DEBUG_SOURCE_APPLICATION:     return "Application";
+			case GL_DEBUG_SOURCE_OTHER:           return "Other";
+		}
+		return "";
+	}
+
+	const char* gl_debug_severity_txt(GLenum severity) {
+		switch (severity) {
+			case GL_DEBUG_SEVERITY_HIGH:         return "High";
+			case GL_DEBUG_SEVERITY_MEDIUM:       return "Medium";
+			case GL_DEBUG_SEVERITY_LOW:          return "Low";
+			case GL_DEBUG_SEVERITY_NOTIFICATION: return "Notification";
+		}
+		return "";
+	}
+
+	// Find or claim the repeat counter of a message
+	// Sets claimed if this is the first copy, returns NULL if the table is full
+	// Messages count as repeats only if their text is the same too,
+	// some drivers use one ID (the error code) for many different errors
+	DebugRepeat* gl_debug_repeat_find(GLenum source, GLenum type, GLuint id, const GLchar* message, size_t size, bool& claimed) {
+		auto& log = g_gl_debug_log;
+
+		// FNV-1a over source, type, ID and text
+		auto key = ((uint64_t) id << 32) | ((uint64_t) (source & 0xFFFF) << 16) | (type & 0xFFFF);
+		key ^= 0xCBF29CE484222325ull;
+		for (auto i = (size_t) 0; i < size; i++) {
+			key ^= (unsigned char) message[i];
+			key *= 0x100000001B3ull;
+		}
+		if (key == 0) key = 1;
+
+		auto hash = (size_t) ((key * 0x9E3779B97F4A7C15ull) >> 32);
+
+		claimed = false;
+		for (auto i = (size_t) 0; i < GL_DEBUG_REPEAT_SLOTS; i++) {
+			auto& repeat = log.repeats[(hash + i) & (GL_DEBUG_REPEAT_SLOTS - 1)];
+			auto current = repeat.key.load(memory_order_acquire);
+			if (current == 0) {
+				if (repeat.key.compare_exchange_strong(current, key, memory_order_acq_rel)) {
+					repeat.id = id;
+					claimed = true;
+					return &repeat;
+				}
+			}
+			// Also reached when another thread just claimed the slot
+			if (current == key) return &repeat;
+		}
+		return NULL;
+	}
+
 	// OpenGL Errors/Warnings Callback
+	// Only counts repeats or copies first messages, formatting happens on the logger thread
 	void GLAPIENTRY gl_debug_callback(
 		GLenum source,
 		GLenum type,
@@ -18,58 +197,145 @@ namespace custom {
 		const GLchar* message,
 		const void* user_param
 	) {
-		// Ignore non-significant error/warning codes
-		if(id == 131169 || id == 131185 || id == 131218 || id == 131204) return;
+		auto& log = g_gl_debug_log;
 
-		// Message type
-		auto type_txt = "";
-		switch (type) {
-			case GL_DEBUG_TYPE_ERROR:               type_txt = "Error";                break;
-			case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: type_txt = "Deprecated Behaviour"; break;
-			case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  type_txt = "Undefined Behaviour";  break; 
-			case GL_DEBUG_TYPE_PORTABILITY:         type_txt = "Portability";          break;
-			case GL_DEBUG_TYPE_PERFORMANCE:         type_txt = "Performance";          break;
-			case GL_DEBUG_TYPE_MARKER:              type_txt = "Marker";               break;
-			case GL_DEBUG_TYPE_PUSH_GROUP:          type_txt = "Push Group";           break;
-			case GL_DEBUG_TYPE_POP_GROUP:           type_txt = "Pop Group";            break;
-			case GL_DEBUG_TYPE_OTHER:               type_txt = "Other";                break;
-		}
-		cerr << "GL " << type_txt << " Message:" << endl;
-
-		// Message id
-		cerr << "\tID: " << id << endl;
-
-		// Message source
-		auto src_txt = "";
-		switch (source) {
-			case GL_DEBUG_SOURCE_API:             src_txt = "API";             break;
-			case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   src_txt = "Window System";   break;
-			case GL_DEBUG_SOURCE_SHADER_COMPILER: src_txt = "Shader Compiler"; break;
-			case GL_DEBUG_SOURCE_THIRD_PARTY:     src_txt = "Third Party";     break;
-			case GL_DEBUG_SOURCE_APPLICATION:     src_txt = "Application";     break;
-			case GL_DEBUG_SOURCE_OTHER:           src_txt = "Other";           break;
+		// Runtime filters
+		if (gl_debug_severity_rank(severity) < log.min_severity.load(memory_order_relaxed)) return;
+		for (auto& ignored : log.ignored) {
+			if (ignored.load(memory_order_relaxed) == id) return;
 		}
-		cerr << "\tSource: " << src_txt << endl;
 
-		// Message severity
-		auto severity_txt = "";
-		switch (severity) {
-			case GL_DEBUG_SEVERITY_HIGH:         severity_txt = "High";         break;
-			case GL_DEBUG_SEVERITY_MEDIUM:       severity_txt = "Medium";       break;
-			case GL_DEBUG_SEVERITY_LOW:          severity_txt = "Low";          break;
-			case GL_DEBUG_SEVERITY_NOTIFICATION: severity_txt = "Notification"; break;
+		auto size = length < 0 ? strlen(message) : (size_t) length;
+
+		// Repeats only bump a counter
+		// With a full table every copy goes to the ring
+		bool claimed;
+		auto repeat = gl_debug_repeat_find(source, type, id, message, size, claimed);
+		if (repeat != NULL && !claimed) {
+			repeat->count.fetch_add(1, memory_order_relaxed);
+			return;
+		}
+
+		// Claim a slot, drop the message if the ring is full
+		auto pos = log.head.load(memory_order_relaxed);
+		DebugRecord* record;
+		while (true) {
+			record = &log.ring[pos & (GL_DEBUG_RING_SIZE - 1)];
+			auto sequence = record->sequence.load(memory_order_acquire);
+			if (sequence == pos) {
+				if (log.head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+			} else if (sequence < pos) {
+				log.dropped.fetch_add(1, memory_order_relaxed);
+				if (repeat != NULL) repeat->dropped.store(true, memory_order_release);
+				return;
+			} else {
+				pos = log.head.load(memory_order_relaxed);
+			}
 		}
-		cerr << "\tSeverity: " << severity_txt << endl;
 
-		// Message body
-		cerr << "\tMessage: " << message << endl;
+		record->source   = source;
+		record->type     = type;
+		record->id       = id;
+		record->severity = severity;
+		record->repeat   = repeat;
+
+		size = min(size, (size_t) GL_DEBUG_MESSAGE_SIZE - 1);
+		memcpy(record->message, message, size);
+		record->message[size] = '\0';
+
+		// Publish to the logger thread
+		record->sequence.store(pos + 1, memory_order_release);
+	}
+
+	// Print new messages and repeat counts
+	// Repeated messages (same source, type and ID) are printed once
+	void gl_debug_drain() {
+		auto& log = g_gl_debug_log;
+
+		while (true) {
+			auto& record = log.ring[log.tail & (GL_DEBUG_RING_SIZE - 1)];
+			if (record.sequence.load(memory_order_acquire) != log.tail + 1) break;
+
+			cerr << "GL " << gl_debug_type_txt(record.type) << " Message:" << endl;
+			cerr << "\tID: "       << record.id                                << endl;
+			cerr << "\tSource: "   << gl_debug_source_txt(record.source)       << endl;
+			cerr << "\tSeverity: " << gl_debug_severity_txt(record.severity)   << endl;
+			cerr << "\tMessage: "  << record.message                           << endl;
+
+			if (record.repeat != NULL) record.repeat->printed = true;
+
+			// Hand the slot back to producers
+			record.sequence.store(log.tail + GL_DEBUG_RING_SIZE, memory_order_release);
+			log.tail++;
+		}
+
+		// Counts wait until their first copy is printed (or known to be dropped)
+		for (auto& repeat : log.repeats) {
+			if (repeat.key.load(memory_order_acquire) == 0) continue;
+			if (!repeat.printed && !repeat.dropped.load(memory_order_acquire)) continue;
+
+			auto count = repeat.count.exchange(0, memory_order_relaxed);
+			if (count > 0) cerr << "GL Message ID " << repeat.id << " repeated " << count << " times" << endl;
+		}
+
+		auto dropped = log.dropped.exchange(0, memory_order_relaxed);
+		if (dropped > 0) cerr << "GL Debug: dropped " << dropped << " messages" << endl;
+	}
+
+	// Logger thread
+	void gl_debug_logger() {
+		while (g_gl_debug_log.running) {
+			gl_debug_drain();
+			this_thread::sleep_for(chrono::milliseconds(GL_DEBUG_DRAIN_MS));
+		}
+		gl_debug_drain();
+	}
+
+	// Ignore messages below the given severity
+	// GL_DEBUG_SEVERITY_NOTIFICATION shows everything
+	void gl_debug_set_min_severity(GLenum severity) {
+		g_gl_debug_log.min_severity = gl_debug_severity_rank(severity);
+	}
+
+	// Ignore (or stop ignoring) a message ID
+	void gl_debug_ignore(GLuint id, bool ignore = true) {
+		auto& log = g_gl_debug_log;
+		for (auto& ignored : log.ignored) {
+			if (ignored == id) {
+				if (!ignore) ignored = GL_DEBUG_ID_NONE;
+				return;
+			}
+		}
+		if (!ignore) return;
+		for (auto& ignored : log.ignored) {
+			GLuint empty = GL_DEBUG_ID_NONE;
+			if (ignored.compare_exchange_strong(empty, id)) return;
+		}
+		cerr << "GL Debug: cannot ignore more than " << GL_DEBUG_IGNORE_MAX << " IDs" << endl;
 	}
 
 	// Enable OpenGL Errors / Warnings
-	void gl_debug_enable() {
+	// Synchronous output reports messages inside the offending call,
+	// which helps debugging but slows down every OpenGL call
+	void gl_debug_enable(bool synchronous = false) {
+		auto& log = g_gl_debug_log;
+		if (!log.running.exchange(true)) log.logger = thread(gl_debug_logger);
+
 		glEnable              (GL_DEBUG_OUTPUT);
+		if (synchronous) glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 		glDebugMessageCallback(gl_debug_callback, 0);
 	}
+
+	// Disable OpenGL Errors / Warnings
+	// Prints pending messages before returning
+	void gl_debug_disable() {
+		glDisable             (GL_DEBUG_OUTPUT);
+		glDisable             (GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		glDebugMessageCallback(NULL, 0);
+
+		auto& log = g_gl_debug_log;
+		if (log.running.exchange(false)) log.logger.join();
+	}
 }
 
 #endif // __CUSTOM_GL_DEBUG__
@@ -13,6 +13,11 @@ namespace custom {
 	template <class T> void glBufferDataV(GLenum target, const vector<T> v, GLenum usage) {
 		glBufferData(target, v.size() * sizeof(T), &v.front(), usage);
 	}
+
+	// Move arrays of known length to GPU buffer
+	template <class T> void glBufferDataA(GLenum target, const T* a, size_t count, GLenum usage) {
+		glBufferData(target, count * sizeof(T), a, usage);
+	}
 }
 
 #endif // __CUSTOM_GL_HELPERS__
@@ -3,12 +3,28 @@
 #ifndef __CUSTOM_GL_SHADER__
 #define __CUSTOM_GL_SHADER__
 
+#include <cstring>
 #include <iostream>
 
+// Shaders compiled into the binary
+#ifdef EMBED_ASSETS
+	#include "embedded.cpp"
+#endif
+
 namespace custom {
 	using namespace std;
 
 	GLchar* gl_load_shader_code(const char* filename) {
+		// Skip file I/O for shaders embedded at compile time
+		#ifdef EMBED_ASSETS
+			auto embedded_code = embedded_shader_find(filename);
+			if (embedded_code != NULL) {
+				auto code = new GLchar[strlen(embedded_code) + 1];
+				strcpy(code, embedded_code);
+				return code;
+			}
+		#endif
+
 		auto file = fopen(filename, "r");
 
 		if (file == NULL) {
@@ -0,0 +1,136 @@
+// Record / Replay Keyboard and Mouse Input
+
+#ifndef __CUSTOM_INPUT_LOG__
+#define __CUSTOM_INPUT_LOG__
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// GLFW
+// Handles windowing operations and keyboard/mouse events
+#include <GLFW/glfw3.h>
+
+// Input event kinds
+#define INPUT_KEY    0
+#define INPUT_MOUSE  1
+#define INPUT_END    2 // Frame at which the recording stopped
+
+// File signature
+#define INPUT_MAGIC "INP1"
+
+namespace custom {
+	using namespace std;
+
+	// One input event, 8 bytes on disk
+	struct InputEvent {
+		uint32_t frame;
+		uint16_t code;   // GLFW key or mouse button
+		uint8_t  kind;
+		uint8_t  action; // GLFW action
+	};
+
+	// Recorded events, either being written or being replayed
+	struct InputLog {
+		FILE* file = NULL;
+
+		// Whether the recorded run was headless, stored after the signature
+		bool headless = false;
+
+		vector<InputEvent> events;
+		size_t next  = 0;
+		long   end   = -1; // Frame of the INPUT_END event, if any
+	};
+
+	// Start writing events to a file
+	void input_record_start(InputLog& log, const char* filename, bool headless) {
+		log.file = fopen(filename, "wb");
+
+		if (log.file == NULL) {
+			cerr << "Failed to open " << filename << "." << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		fwrite(INPUT_MAGIC, 1, 4, log.file);
+
+		log.headless = headless;
+		uint32_t flags = headless ? 1 : 0;
+		fwrite(&flags, sizeof(flags), 1, log.file);
+	}
+
+	// Record an event that happened while processing the given frame
+	void input_record(InputLog& log, long frame, int kind, int code, int action) {
+		if (log.file == NULL) return;
+
+		auto event = InputEvent { (uint32_t) frame, (uint16_t) code, (uint8_t) kind, (uint8_t) action };
+		fwrite(&event, sizeof(event), 1, log.file);
+	}
+
+	// Mark the frame the run ended at and close the file
+	void input_record_stop(InputLog& log, long frame) {
+		if (log.file == NULL) return;
+
+		input_record(log, frame, INPUT_END, 0, 0);
+		fclose(log.file);
+		log.file = NULL;
+	}
+
+	// Load a recording for replay
+	void input_replay_load(InputLog& log, const char* filename) {
+		auto file = fopen(filename, "rb");
+
+		if (file == NULL) {
+			cerr << "Failed to open " << filename << "." << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		char magic[4];
+		uint32_t flags;
+		if (
+			fread(magic, 1, 4, file) != 4 || memcmp(magic, INPUT_MAGIC, 4) != 0 ||
+			fread(&flags, sizeof(flags), 1, file) != 1
+		) {
+			cerr << filename << " is not an input recording." << endl;
+			fclose(file);
+			exit(EXIT_FAILURE);
+		}
+
+		log.headless = flags & 1;
+
+		InputEvent event;
+		while (fread(&event, sizeof(event), 1, file) == 1) {
+			if (event.kind == INPUT_END) log.end = event.frame;
+			else                         log.events.push_back(event);
+		}
+
+		fclose(file);
+
+		log.next = 0;
+	}
+
+	// Feed the events recorded at the given frame to the callbacks
+	// Call where the recording polled events, so they land on the same frame
+	void input_replay_frame(
+		InputLog& log,
+		long frame,
+		GLFWwindow* window,
+		GLFWkeyfun key_callback,
+		GLFWmousebuttonfun mouse_button_callback
+	) {
+		while (log.next < log.events.size() && log.events[log.next].frame <= frame) {
+			auto& event = log.events[log.next++];
+			if      (event.kind == INPUT_KEY)   key_callback(window, event.code, 0, event.action, 0);
+			else if (event.kind == INPUT_MOUSE) mouse_button_callback(window, event.code, event.action, 0);
+		}
+	}
+
+	// Check whether a replay reached the frame its recording stopped at
+	bool input_replay_done(const InputLog& log, long frame) {
+		if (log.end >= 0) return frame >= log.end;
+		return log.next >= log.events.size();
+	}
+}
+
+#endif // __CUSTOM_INPUT_LOG__
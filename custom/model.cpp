@@ -5,8 +5,13 @@
 
 #include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 
+// GLM
+// OpenGL math library
+#include <glm/glm.hpp>
+
 #define VERTEX_3D_COMPONENTS 3
 #define TRIANGLE_POINTS      3
 
@@ -15,6 +20,8 @@ namespace custom {
 
 	// Represents 3D Model
 	struct Model {
+		string filename;
+
 		GLint vertex_count;
 		GLint triangle_count;
 
@@ -38,6 +45,20 @@ namespace custom {
 		~Model() { }
 	};
 
+	// Find the lowest vertex (y-axis)
+	// Models without vertices have their lowest vertex at 0
+	GLfloat model_lowest_vertex(const vector<GLfloat>& v) {
+		if (v.size() < VERTEX_3D_COMPONENTS) return 0.0f;
+
+		auto min = v[1];
+
+		for (auto i = (size_t) 1; i < v.size(); i += 3) {
+			if (v[i] < min) min = v[i];
+		}
+
+		return min;
+	}
+
 	// Load a 3D model in TLST (custom) file format
 	Model model_tlst_load(const char* filename) {
 		ifstream file;
@@ -47,6 +68,7 @@ namespace custom {
 		file >> vertex_count >> triangle_count;
 
 		auto model = Model(vertex_count, triangle_count);
+		model.filename = filename;
 
 		// Read vertex coordinates
 		for (auto& i : model.vertices) file >> i;
@@ -54,17 +76,37 @@ namespace custom {
 		// Read triangle vertex indices
 		for (auto& i : model.triangles) file >> i;
 
-		// Find the lowest vertex (y-axis)
-		auto v   = model.vertices;
-		auto min = v[1];
+		model.lowest_vertex = model_lowest_vertex(model.vertices);
 
-		for (auto i = (size_t) 1; i < v.size() - 2; i += 3) {
-			if (v[i] < min) min = v[i];
-		}
+		return model;
+	}
 
-		model.lowest_vertex = min;
+	// Save a 3D model in TLST (custom) file format
+	// Vertices are transformed before saving
+	void model_tlst_save(const Model& model, const char* filename, const glm::mat4& transform) {
+		ofstream new_model;
+		new_model.open(filename);
+
+		auto& v = model.vertices;
+		auto& t = model.triangles;
+		new_model << model.vertex_count << " " << model.triangle_count << endl;
+		new_model << endl;
+		for (auto i = (size_t) 0; i + 2 < v.size(); i += 3) {
+			auto old_v = glm::vec4(v[i], v[i + 1], v[i + 2], 1.0f);
+			auto new_v = transform * old_v;
+			new_model << new_v.x << " " << new_v.y << " " << new_v.z << endl;
+		}
+		new_model << endl;
+		for (auto i = (size_t) 0; i + 2 < t.size(); i += 3) {
+			new_model << t[i] << " " << t[i + 1] << " " << t[i + 2] << endl;
+		}
+	}
 
-		return model;
+	// Free CPU copies of the vertex data
+	// Counts and lowest vertex are kept, e.g. for drawing after upload
+	void model_free_cpu(Model& model) {
+		vector<GLfloat>().swap(model.vertices);
+		vector<GLint>().swap(model.triangles);
 	}
 }
 
@@ -0,0 +1,412 @@
+// Import OBJ / PLY Models
+
+#ifndef __CUSTOM_MODEL_IMPORT__
+#define __CUSTOM_MODEL_IMPORT__
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "model.cpp"
+
+// PLY scalar types
+#define PLY_INT8    0
+#define PLY_UINT8   1
+#define PLY_INT16   2
+#define PLY_UINT16  3
+#define PLY_INT32   4
+#define PLY_UINT32  5
+#define PLY_FLOAT32 6
+#define PLY_FLOAT64 7
+#define PLY_NONE   -1
+
+namespace custom {
+	using namespace std;
+
+	// Read a whole file with a single bulk read
+	vector<char> model_read_file(const char* filename) {
+		auto file = fopen(filename, "rb");
+
+		if (file == NULL) {
+			cerr << "Failed to open " << filename << "." << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		// Determine file size
+		fseek(file, 0, SEEK_END);
+		auto file_size = ftell(file);
+		rewind(file);
+
+		auto data = vector<char>(file_size);
+		auto read_size = (long int) fread(data.data(), 1, file_size, file);
+		fclose(file);
+
+		if (read_size != file_size) {
+			cerr << "Failed to read " << filename << "." << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		return data;
+	}
+
+	// Fail on malformed model files
+	void model_import_fail(const char* filename, const char* reason) {
+		cerr << "Failed to import " << filename << ": " << reason << "." << endl;
+		exit(EXIT_FAILURE);
+	}
+
+	// Set counts and lowest vertex once vertices and triangles are filled in
+	void model_import_finish(Model& model, const char* filename) {
+		model.filename       = filename;
+		model.vertex_count   = model.vertices.size()  / VERTEX_3D_COMPONENTS;
+		model.triangle_count = model.triangles.size() / TRIANGLE_POINTS;
+
+		if (model.vertex_count == 0 || model.triangle_count == 0) model_import_fail(filename, "no triangles");
+
+		for (auto i : model.triangles) {
+			if (i < 0 || i >= model.vertex_count) model_import_fail(filename, "vertex index out of range");
+		}
+
+		model.lowest_vertex = model_lowest_vertex(model.vertices);
+	}
+
+	// Add a polygon as a triangle fan
+	void model_add_polygon(Model& model, const vector<GLint>& polygon) {
+		for (auto i = (size_t) 2; i < polygon.size(); i++) {
+			model.triangles.push_back(polygon[0]);
+			model.triangles.push_back(polygon[i - 1]);
+			model.triangles.push_back(polygon[i]);
+		}
+	}
+
+	/* OBJ */
+
+	// Skip spaces and tabs
+	const char* obj_skip_space(const char* p, const char* end) {
+		while (p < end && (*p == ' ' || *p == '\t')) p++;
+		return p;
+	}
+
+	// Skip an optional leading '+', which from_chars does not accept
+	const char* obj_skip_plus(const char* p, const char* end) {
+		if (p + 1 < end && *p == '+' && p[1] != '-' && p[1] != '+') p++;
+		return p;
+	}
+
+	// Parse a float, return the end of the number or NULL on failure
+	// Floating-point from_chars is missing from older libc++ (Xcode < 16)
+	const char* obj_parse_float(const char* p, const char* end, GLfloat& value) {
+		#ifdef __cpp_lib_to_chars
+			auto result = from_chars(obj_skip_plus(p, end), end, value);
+			return result.ec == errc() ? result.ptr : NULL;
+		#else
+			// strtof needs a terminated string, the file data is not
+			char number[64];
+			auto length = min((size_t) (end - p), sizeof(number) - 1);
+			memcpy(number, p, length);
+			number[length] = '\0';
+
+			char* number_end;
+			value = strtof(number, &number_end);
+			return number_end == number ? NULL : p + (number_end - number);
+		#endif
+	}
+
+	// Load a 3D model in Wavefront OBJ format
+	// Only vertex positions (v) and faces (f) are used
+	Model model_obj_load(const char* filename) {
+		auto data = model_read_file(filename);
+		auto model = Model(0, 0);
+
+		// Rough guess from file size, avoids most reallocations
+		model.vertices.reserve(data.size() / 16);
+		model.triangles.reserve(data.size() / 16);
+
+		vector<GLint> polygon;
+
+		auto p   = (const char*) data.data();
+		auto end = p + data.size();
+
+		while (p < end) {
+			// Split lines with memchr, which scans many bytes at once
+			auto eol = (const char*) memchr(p, '\n', end - p);
+			if (eol == NULL) eol = end;
+
+			auto line = obj_skip_space(p, eol);
+
+			if (eol - line > 1 && line[0] == 'v' && (line[1] == ' ' || line[1] == '\t')) {
+				// Vertex: v x y z [w]
+				line += 2;
+				for (auto i = 0; i < VERTEX_3D_COMPONENTS; i++) {
+					line = obj_skip_space(line, eol);
+					GLfloat value;
+					line = obj_parse_float(line, eol, value);
+					if (line == NULL) model_import_fail(filename, "bad vertex");
+					model.vertices.push_back(value);
+				}
+			} else if (eol - line > 1 && line[0] == 'f' && (line[1] == ' ' || line[1] == '\t')) {
+				// Face: f v1 v2 v3 ..., each as v, v/vt, v//vn or v/vt/vn
+				line += 2;
+				polygon.clear();
+				while (true) {
+					line = obj_skip_space(line, eol);
+					if (line >= eol || *line == '\r' || *line == '#') break;
+
+					GLint index;
+					auto result = from_chars(obj_skip_plus(line, eol), eol, index);
+					if (result.ec != errc() || index == 0) model_import_fail(filename, "bad face");
+
+					// Negative indices count back from the last vertex
+					auto vertex_count = (GLint) (model.vertices.size() / VERTEX_3D_COMPONENTS);
+					polygon.push_back(index > 0 ? index - 1 : vertex_count + index);
+
+					// Skip texture/normal indices
+					line = result.ptr;
+					while (line < eol && *line != ' ' && *line != '\t' && *line != '\r') line++;
+				}
+				model_add_polygon(model, polygon);
+			}
+
+			p = eol + 1;
+		}
+
+		model_import_finish(model, filename);
+
+		return model;
+	}
+
+	/* PLY */
+
+	struct PlyProperty {
+		string name;
+		int    type;
+		int    count_type; // PLY_NONE unless property is a list
+	};
+
+	struct PlyElement {
+		string name;
+		size_t count;
+		vector<PlyProperty> properties;
+	};
+
+	int ply_type(const string& name) {
+		if (name == "char"   || name == "int8")    return PLY_INT8;
+		if (name == "uchar"  || name == "uint8")   return PLY_UINT8;
+		if (name == "short"  || name == "int16")   return PLY_INT16;
+		if (name == "ushort" || name == "uint16")  return PLY_UINT16;
+		if (name == "int"    || name == "int32")   return PLY_INT32;
+		if (name == "uint"   || name == "uint32")  return PLY_UINT32;
+		if (name == "float"  || name == "float32") return PLY_FLOAT32;
+		if (name == "double" || name == "float64") return PLY_FLOAT64;
+		return PLY_NONE;
+	}
+
+	size_t ply_type_size(int type) {
+		switch (type) {
+			case PLY_INT8:    case PLY_UINT8:   return 1;
+			case PLY_INT16:   case PLY_UINT16:  return 2;
+			case PLY_INT32:   case PLY_UINT32:  return 4;
+			case PLY_FLOAT32:                   return 4;
+			case PLY_FLOAT64:                   return 8;
+		}
+		return 0;
+	}
+
+	// Read one binary scalar, swapping bytes if the file's byte order differs
+	double ply_read(const char* p, int type, bool swap) {
+		unsigned char bytes[8];
+		auto size = ply_type_size(type);
+		memcpy(bytes, p, size);
+		if (swap) {
+			for (auto i = (size_t) 0; i < size / 2; i++) std::swap(bytes[i], bytes[size - 1 - i]);
+		}
+
+		switch (type) {
+			case PLY_INT8:    { int8_t   v; memcpy(&v, bytes, 1); return v; }
+			case PLY_UINT8:   { uint8_t  v; memcpy(&v, bytes, 1); return v; }
+			case PLY_INT16:   { int16_t  v; memcpy(&v, bytes, 2); return v; }
+			case PLY_UINT16:  { uint16_t v; memcpy(&v, bytes, 2); return v; }
+			case PLY_INT32:   { int32_t  v; memcpy(&v, bytes, 4); return v; }
+			case PLY_UINT32:  { uint32_t v; memcpy(&v, bytes, 4); return v; }
+			case PLY_FLOAT32: { float    v; memcpy(&v, bytes, 4); return v; }
+			case PLY_FLOAT64: { double   v; memcpy(&v, bytes, 8); return v; }
+		}
+		return 0;
+	}
+
+	// Load a 3D model in binary PLY format
+	// Uses vertex x/y/z and face vertex_indices (or vertex_index)
+	Model model_ply_load(const char* filename) {
+		auto data = model_read_file(filename);
+		auto model = Model(0, 0);
+
+		/* Header */
+
+		auto header_end = string(data.data(), min(data.size(), (size_t) 65536)).find("end_header");
+		if (data.size() < 3 || memcmp(data.data(), "ply", 3) != 0 || header_end == string::npos) {
+			model_import_fail(filename, "not a PLY file");
+		}
+
+		auto header = istringstream(string(data.data(), header_end));
+		vector<PlyElement> elements;
+		auto swap = false;
+
+		string line;
+		while (getline(header, line)) {
+			auto words = istringstream(line);
+			string keyword;
+			words >> keyword;
+
+			if (keyword == "format") {
+				string format;
+				words >> format;
+
+				uint16_t probe = 1;
+				auto little_endian_host = *(unsigned char*) &probe == 1;
+
+				if      (format == "binary_little_endian") swap = !little_endian_host;
+				else if (format == "binary_big_endian")    swap =  little_endian_host;
+				else model_import_fail(filename, "only binary PLY is supported");
+			} else if (keyword == "element") {
+				PlyElement element;
+				words >> element.name >> element.count;
+				elements.push_back(element);
+			} else if (keyword == "property" && !elements.empty()) {
+				PlyProperty property;
+				string type;
+				words >> type;
+				if (type == "list") {
+					string count_type;
+					words >> count_type >> type;
+					property.count_type = ply_type(count_type);
+					if (property.count_type == PLY_NONE) model_import_fail(filename, "bad property type");
+				} else {
+					property.count_type = PLY_NONE;
+				}
+				property.type = ply_type(type);
+				if (property.type == PLY_NONE) model_import_fail(filename, "bad property type");
+				words >> property.name;
+				elements.back().properties.push_back(property);
+			}
+		}
+
+		/* Body */
+
+		// Body starts after the "end_header" line
+		auto body_start = (const char*) memchr(data.data() + header_end, '\n', data.size() - header_end);
+		if (body_start == NULL) model_import_fail(filename, "truncated file");
+
+		auto p   = body_start + 1;
+		auto end = (const char*) data.data() + data.size();
+
+		vector<GLint> polygon;
+
+		for (auto& element : elements) {
+			// Fixed-size elements are decoded from the block with a constant stride
+			auto stride = (size_t) 0;
+			auto fixed  = true;
+			for (auto& property : element.properties) {
+				if (property.count_type != PLY_NONE) fixed = false;
+				stride += ply_type_size(property.type);
+			}
+
+			if (element.name == "vertex") {
+				if (!fixed) model_import_fail(filename, "list property in vertex");
+				if (stride == 0) model_import_fail(filename, "vertex without properties");
+				if ((size_t) (end - p) / stride < element.count) model_import_fail(filename, "truncated file");
+
+				// Offsets and types of x, y and z
+				size_t offsets[VERTEX_3D_COMPONENTS];
+				int    types[VERTEX_3D_COMPONENTS] = { PLY_NONE, PLY_NONE, PLY_NONE };
+				auto offset = (size_t) 0;
+				for (auto& property : element.properties) {
+					auto axis = property.name == "x" ? 0 : property.name == "y" ? 1 : property.name == "z" ? 2 : -1;
+					if (axis >= 0) {
+						offsets[axis] = offset;
+						types[axis]   = property.type;
+					}
+					offset += ply_type_size(property.type);
+				}
+				for (auto type : types) {
+					if (type == PLY_NONE) model_import_fail(filename, "vertex without x, y and z");
+				}
+
+				model.vertices.resize(element.count * VERTEX_3D_COMPONENTS);
+				auto v = model.vertices.data();
+				for (auto i = (size_t) 0; i < element.count; i++, p += stride) {
+					for (auto axis = 0; axis < VERTEX_3D_COMPONENTS; axis++) {
+						*v++ = ply_read(p + offsets[axis], types[axis], swap);
+					}
+				}
+			} else if (element.name == "face") {
+				model.triangles.reserve(element.count * TRIANGLE_POINTS);
+				for (auto i = (size_t) 0; i < element.count; i++) {
+					for (auto& property : element.properties) {
+						if (property.count_type == PLY_NONE) {
+							p += ply_type_size(property.type);
+							continue;
+						}
+
+						auto count_size = ply_type_size(property.count_type);
+						if (p > end || (size_t) (end - p) < count_size) model_import_fail(filename, "truncated file");
+						auto count = (size_t) ply_read(p, property.count_type, swap);
+						p += count_size;
+
+						auto index_size = ply_type_size(property.type);
+						if ((size_t) (end - p) / index_size < count) model_import_fail(filename, "truncated file");
+
+						if (property.name == "vertex_indices" || property.name == "vertex_index") {
+							polygon.clear();
+							for (auto j = (size_t) 0; j < count; j++) polygon.push_back(ply_read(p + j * index_size, property.type, swap));
+							model_add_polygon(model, polygon);
+						}
+						p += count * index_size;
+					}
+				}
+			} else {
+				// Skip other elements
+				for (auto i = (size_t) 0; i < element.count; i++) {
+					for (auto& property : element.properties) {
+						if (property.count_type == PLY_NONE) {
+							p += ply_type_size(property.type);
+							continue;
+						}
+						if (p > end || (size_t) (end - p) < ply_type_size(property.count_type)) model_import_fail(filename, "truncated file");
+						auto count = (size_t) ply_read(p, property.count_type, swap);
+						p += ply_type_size(property.count_type) + count * ply_type_size(property.type);
+					}
+				}
+			}
+
+			if (p > end) model_import_fail(filename, "truncated file");
+		}
+
+		model_import_finish(model, filename);
+
+		return model;
+	}
+
+	/* Any Format */
+
+	// Load a 3D model, picking the format from the file extension
+	// .obj and .ply are imported, anything else is read as TLST
+	Model model_load(const char* filename) {
+		auto name = string(filename);
+		auto ext  = name.substr(name.find_last_of('.') + 1);
+		for (auto& c : ext) c = tolower(c);
+
+		if (ext == "obj") return model_obj_load(filename);
+		if (ext == "ply") return model_ply_load(filename);
+		return model_tlst_load(filename);
+	}
+}
+
+#endif // __CUSTOM_MODEL_IMPORT__
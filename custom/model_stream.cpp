@@ -0,0 +1,170 @@
+// Progressive Loading of Large Models
+
+#ifndef __CUSTOM_MODEL_STREAM__
+#define __CUSTOM_MODEL_STREAM__
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "model.cpp"
+#include "resources.cpp"
+
+namespace custom {
+	using namespace std;
+
+	// TLST file being parsed and uploaded a chunk at a time
+	// Only one chunk of vertex data is ever held in CPU memory
+	struct ModelStream {
+		ifstream file;
+
+		// Totals from the file header
+		GLint vertex_count;
+		GLint triangle_count;
+
+		GLint vertices_loaded;
+		GLint triangles_loaded;
+
+		size_t chunk;
+		vector<GLfloat> vertex_chunk;
+		vector<GLint>   triangle_chunk;
+
+		bool done;
+	};
+
+	// CPU bytes held by a stream's chunk buffers
+	size_t model_stream_cpu_bytes(const ModelStream& stream) {
+		return stream.vertex_chunk.capacity()   * sizeof(GLfloat)
+		     + stream.triangle_chunk.capacity() * sizeof(GLint);
+	}
+
+	// Open a TLST model and allocate GPU storage for all of it
+	// The returned model draws only the triangles loaded so far:
+	// its triangle_count grows with every model_stream_step
+	Model model_stream_open(const char* filename, ModelStream& stream, size_t chunk) {
+		stream.file.open(filename);
+
+		if (!stream.file) {
+			cerr << "Failed to open " << filename << "." << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		stream.file >> stream.vertex_count >> stream.triangle_count;
+
+		if (!stream.file || stream.vertex_count < 0 || stream.triangle_count < 0) {
+			cerr << "Failed to read the header of " << filename << "." << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		// Check before allocating, the whole model is allocated up front
+		if (!resource_fits(0, model_gpu_bytes(stream.vertex_count, stream.triangle_count))) {
+			cerr << "Model " << filename << " does not fit in the GPU memory budget." << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		stream.vertices_loaded  = 0;
+		stream.triangles_loaded = 0;
+		stream.chunk = chunk;
+		stream.vertex_chunk.reserve(chunk * VERTEX_3D_COMPONENTS);
+		stream.triangle_chunk.reserve(chunk * TRIANGLE_POINTS);
+		stream.done = false;
+
+		auto model = Model(0, 0);
+		model.filename       = filename;
+		model.vertex_count   = stream.vertex_count;
+		model.triangle_count = 0;
+		model.lowest_vertex  = 0;
+
+		glGenVertexArrays(1, &model.VAO);
+		glGenBuffers(1, &model.VBO);
+		glGenBuffers(1, &model.EBO);
+
+		glBindVertexArray(model.VAO);
+
+		// Allocate only, data arrives in chunks
+		glBindBuffer(GL_ARRAY_BUFFER, model.VBO);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) stream.vertex_count * VERTEX_3D_COMPONENTS * sizeof(GLfloat), NULL, GL_STATIC_DRAW);
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model.EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) stream.triangle_count * TRIANGLE_POINTS * sizeof(GLint), NULL, GL_STATIC_DRAW);
+
+		glVertexAttribPointer(0, VERTEX_3D_COMPONENTS, GL_FLOAT, GL_TRUE, 0, (void*) 0);
+		glEnableVertexAttribArray(0);
+
+		glBindVertexArray(0);
+
+		return model;
+	}
+
+	// Parse and upload up to one chunk of vertices or triangles
+	// Vertices come first, so triangles never reference missing vertices
+	// Returns true once the whole model is uploaded
+	bool model_stream_step(ModelStream& stream, Model& model) {
+		if (stream.done) return true;
+
+		glBindVertexArray(model.VAO);
+
+		if (stream.vertices_loaded < stream.vertex_count) {
+			auto count = min((GLint) stream.chunk, stream.vertex_count - stream.vertices_loaded);
+			auto& v = stream.vertex_chunk;
+
+			v.resize(count * VERTEX_3D_COMPONENTS);
+			for (auto& i : v) stream.file >> i;
+
+			// Track the lowest vertex (y-axis) as vertices arrive
+			auto first = stream.vertices_loaded == 0;
+			for (auto i = (size_t) 1; i < v.size(); i += 3) {
+				if (first || v[i] < model.lowest_vertex) model.lowest_vertex = v[i];
+				first = false;
+			}
+
+			glBindBuffer(GL_ARRAY_BUFFER, model.VBO);
+			glBufferSubData(
+				GL_ARRAY_BUFFER,
+				(GLintptr) stream.vertices_loaded * VERTEX_3D_COMPONENTS * sizeof(GLfloat),
+				v.size() * sizeof(GLfloat),
+				&v.front()
+			);
+
+			stream.vertices_loaded += count;
+		} else if (stream.triangles_loaded < stream.triangle_count) {
+			auto count = min((GLint) stream.chunk, stream.triangle_count - stream.triangles_loaded);
+			auto& t = stream.triangle_chunk;
+
+			t.resize(count * TRIANGLE_POINTS);
+			for (auto& i : t) stream.file >> i;
+
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model.EBO);
+			glBufferSubData(
+				GL_ELEMENT_ARRAY_BUFFER,
+				(GLintptr) stream.triangles_loaded * TRIANGLE_POINTS * sizeof(GLint),
+				t.size() * sizeof(GLint),
+				&t.front()
+			);
+
+			stream.triangles_loaded += count;
+			model.triangle_count     = stream.triangles_loaded;
+		}
+
+		glBindVertexArray(0);
+
+		if (!stream.file) {
+			cerr << "Failed to read " << model.filename << "." << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		if (stream.triangles_loaded == stream.triangle_count && stream.vertices_loaded == stream.vertex_count) {
+			stream.done = true;
+			stream.file.close();
+
+			// Everything is on the GPU, the chunk buffers are not needed anymore
+			vector<GLfloat>().swap(stream.vertex_chunk);
+			vector<GLint>().swap(stream.triangle_chunk);
+		}
+
+		return stream.done;
+	}
+}
+
+#endif // __CUSTOM_MODEL_STREAM__
@@ -0,0 +1,57 @@
+// Bouncing Object Simulation
+
+#ifndef __CUSTOM_PHYSICS__
+#define __CUSTOM_PHYSICS__
+
+// GLM
+// OpenGL math library
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Simulation constants
+#define GROUND         -1.00f
+#define HIT_FACTOR      0.85f
+#define REVERSE_FACTOR -1.00f
+
+namespace custom {
+	using namespace std;
+
+	// Position, velocity and acceleration of a simulated object
+	struct Body {
+		float x_pos;
+		float y_pos;
+		float x_vel;
+		float y_vel;
+		float y_acc;
+	};
+
+	// Put body back at its initial position
+	void body_reset(Body& body) {
+		body.x_pos = 0;
+		body.y_pos = 0;
+		body.x_vel = 0.005f;
+		body.y_vel = 0;
+		body.y_acc = -0.00098f;
+	}
+
+	// Advance body by one frame, bouncing off the ground
+	// Returns the transform to draw the body with this frame
+	glm::mat4 body_step(Body& body, GLfloat lowest_vertex) {
+		body.y_vel += body.y_acc;
+
+		body.x_pos += body.x_vel;
+		body.y_pos += body.y_vel;
+
+		auto transform = glm::mat4(1.0f);
+		transform = glm::translate(transform, glm::vec3(body.x_pos, body.y_pos, 0.0f));
+
+		if (body.y_pos + lowest_vertex < GROUND) {
+			body.y_vel *= REVERSE_FACTOR * HIT_FACTOR;
+			body.y_pos = GROUND - lowest_vertex;
+		}
+
+		return transform;
+	}
+}
+
+#endif // __CUSTOM_PHYSICS__
@@ -0,0 +1,112 @@
+// Minimal PNG Writer
+
+#ifndef __CUSTOM_PNG__
+#define __CUSTOM_PNG__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Largest stored (uncompressed) deflate block
+#define PNG_DEFLATE_BLOCK 65535
+
+namespace custom {
+	using namespace std;
+
+	// CRC-32 as used by PNG chunks
+	uint32_t png_crc(const unsigned char* data, size_t size, uint32_t crc = 0) {
+		static uint32_t table[256];
+		static bool table_ready = false;
+
+		if (!table_ready) {
+			for (uint32_t n = 0; n < 256; n++) {
+				auto c = n;
+				for (auto k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				table[n] = c;
+			}
+			table_ready = true;
+		}
+
+		crc = ~crc;
+		for (auto i = (size_t) 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	void png_put_u32(vector<unsigned char>& out, uint32_t value) {
+		out.push_back(value >> 24);
+		out.push_back(value >> 16);
+		out.push_back(value >> 8);
+		out.push_back(value);
+	}
+
+	// Append a chunk (length, type, data, CRC)
+	void png_put_chunk(vector<unsigned char>& out, const char* type, const vector<unsigned char>& data) {
+		png_put_u32(out, data.size());
+
+		auto start = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data.begin(), data.end());
+
+		png_put_u32(out, png_crc(&out[start], out.size() - start));
+	}
+
+	// Write 8-bit RGBA pixels (top row first) as a PNG file
+	// Uses stored deflate blocks: no compression, but no encoding cost either
+	bool png_write(const char* filename, const unsigned char* pixels, int width, int height) {
+		auto row_size = (size_t) width * 4;
+
+		// Scanlines, each prefixed with filter type 0 (none)
+		vector<unsigned char> raw;
+		raw.reserve((row_size + 1) * height);
+		for (auto y = 0; y < height; y++) {
+			raw.push_back(0);
+			raw.insert(raw.end(), pixels + y * row_size, pixels + (y + 1) * row_size);
+		}
+
+		// zlib stream made of stored blocks
+		vector<unsigned char> idat;
+		idat.reserve(raw.size() + raw.size() / PNG_DEFLATE_BLOCK * 5 + 16);
+		idat.push_back(0x78);
+		idat.push_back(0x01);
+
+		for (auto i = (size_t) 0; i < raw.size() || i == 0; i += PNG_DEFLATE_BLOCK) {
+			auto size = min((size_t) PNG_DEFLATE_BLOCK, raw.size() - i);
+			idat.push_back(i + size == raw.size());
+			idat.push_back(size & 0xFF);
+			idat.push_back(size >> 8);
+			idat.push_back(~size & 0xFF);
+			idat.push_back((~size >> 8) & 0xFF);
+			idat.insert(idat.end(), raw.begin() + i, raw.begin() + i + size);
+		}
+
+		// Adler-32 of the uncompressed data
+		uint32_t a = 1, b = 0;
+		for (auto byte : raw) {
+			a = (a + byte) % 65521;
+			b = (b + a) % 65521;
+		}
+		png_put_u32(idat, (b << 16) | a);
+
+		// Header: size, 8-bit depth, RGBA, default compression/filter/interlace
+		vector<unsigned char> ihdr;
+		png_put_u32(ihdr, width);
+		png_put_u32(ihdr, height);
+		ihdr.insert(ihdr.end(), { 8, 6, 0, 0, 0 });
+
+		vector<unsigned char> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		png_put_chunk(png, "IHDR", ihdr);
+		png_put_chunk(png, "IDAT", idat);
+		png_put_chunk(png, "IEND", {});
+
+		auto file = fopen(filename, "wb");
+		if (file == NULL) return false;
+
+		auto written = fwrite(&png.front(), 1, png.size(), file);
+		fclose(file);
+
+		return written == png.size();
+	}
+}
+
+#endif // __CUSTOM_PNG__
@@ -0,0 +1,165 @@
+// Resource Memory Accounting
+
+#ifndef __CUSTOM_RESOURCES__
+#define __CUSTOM_RESOURCES__
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "model.cpp"
+
+namespace custom {
+	using namespace std;
+
+	// Bytes held by one resource
+	struct ResourceUsage {
+		size_t cpu_bytes;
+		size_t gpu_bytes;
+	};
+
+	// All tracked resources, totals, high-water marks and budgets
+	// A budget of 0 means unlimited
+	struct ResourceStats {
+		map<string, ResourceUsage> usage;
+
+		size_t cpu_total  = 0;
+		size_t gpu_total  = 0;
+		size_t cpu_peak   = 0;
+		size_t gpu_peak   = 0;
+		size_t cpu_budget = 0;
+		size_t gpu_budget = 0;
+	};
+
+	ResourceStats g_resources;
+
+	// Human-readable byte count
+	string resource_bytes_txt(size_t bytes) {
+		const char* units[] = { "B", "KiB", "MiB", "GiB" };
+		auto value = (double) bytes;
+		auto unit  = 0;
+		while (value >= 1024 && unit < 3) {
+			value /= 1024;
+			unit++;
+		}
+		char txt[32];
+		snprintf(txt, sizeof(txt), unit == 0 ? "%.0f %s" : "%.1f %s", value, units[unit]);
+		return txt;
+	}
+
+	string resource_budget_txt(size_t bytes) {
+		return bytes == 0 ? "unlimited" : resource_bytes_txt(bytes);
+	}
+
+	// Set memory budgets in bytes, 0 means unlimited
+	void resource_set_budget(size_t cpu_bytes, size_t gpu_bytes) {
+		g_resources.cpu_budget = cpu_bytes;
+		g_resources.gpu_budget = gpu_bytes;
+	}
+
+	// Check whether extra bytes fit in the budgets
+	// Use before loading to skip assets that would not fit
+	bool resource_fits(size_t cpu_bytes, size_t gpu_bytes) {
+		auto& r = g_resources;
+		if (r.cpu_budget != 0 && r.cpu_total + cpu_bytes > r.cpu_budget) return false;
+		if (r.gpu_budget != 0 && r.gpu_total + gpu_bytes > r.gpu_budget) return false;
+		return true;
+	}
+
+	// Record the bytes held by a resource, replacing earlier values
+	// Exceeding a budget is fatal
+	void resource_set(const string& name, size_t cpu_bytes, size_t gpu_bytes) {
+		auto& r = g_resources;
+
+		auto old = r.usage.find(name);
+		if (old != r.usage.end()) {
+			r.cpu_total -= old->second.cpu_bytes;
+			r.gpu_total -= old->second.gpu_bytes;
+			r.usage.erase(old);
+		}
+
+		if (!resource_fits(cpu_bytes, gpu_bytes)) {
+			cerr << "Memory budget exceeded by " << name << ":" << endl;
+			cerr << "\tCPU: " << resource_bytes_txt(r.cpu_total + cpu_bytes) << " of " << resource_budget_txt(r.cpu_budget) << endl;
+			cerr << "\tGPU: " << resource_bytes_txt(r.gpu_total + gpu_bytes) << " of " << resource_budget_txt(r.gpu_budget) << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		r.usage[name] = { cpu_bytes, gpu_bytes };
+		r.cpu_total += cpu_bytes;
+		r.gpu_total += gpu_bytes;
+		r.cpu_peak   = max(r.cpu_peak, r.cpu_total);
+		r.gpu_peak   = max(r.gpu_peak, r.gpu_total);
+	}
+
+	// Stop tracking a released resource
+	void resource_release(const string& name) {
+		auto& r = g_resources;
+
+		auto old = r.usage.find(name);
+		if (old == r.usage.end()) return;
+
+		r.cpu_total -= old->second.cpu_bytes;
+		r.gpu_total -= old->second.gpu_bytes;
+		r.usage.erase(old);
+	}
+
+	// GPU bytes of a model's vertex and element buffers
+	size_t model_gpu_bytes(GLint vertex_count, GLint triangle_count) {
+		return (size_t) vertex_count   * VERTEX_3D_COMPONENTS * sizeof(GLfloat)
+		     + (size_t) triangle_count * TRIANGLE_POINTS      * sizeof(GLint);
+	}
+
+	// CPU bytes of a model's vertex and triangle copies
+	size_t model_cpu_bytes(const Model& model) {
+		return model.vertices.capacity()  * sizeof(GLfloat)
+		     + model.triangles.capacity() * sizeof(GLint);
+	}
+
+	// Track a model's CPU copies, before it is uploaded
+	void resource_track_model_cpu(const Model& model) {
+		resource_set(model.filename, model_cpu_bytes(model), 0);
+	}
+
+	// Track a model's CPU copies and GPU buffers
+	// Call after uploading, and again after changing its CPU copies
+	void resource_track_model(const Model& model) {
+		resource_set(model.filename, model_cpu_bytes(model), model_gpu_bytes(model.vertex_count, model.triangle_count));
+	}
+
+	// Track the driver's binary of a linked program
+	// Reports 0 bytes if the driver cannot provide program binaries
+	void resource_track_program(const string& name, GLuint program) {
+		// Program binaries are core since OpenGL 4.1, an extension before
+		GLint major = 0, minor = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &major);
+		glGetIntegerv(GL_MINOR_VERSION, &minor);
+		auto supported = major > 4 || (major == 4 && minor >= 1);
+		#ifndef __APPLE__
+			supported = supported || GLEW_ARB_get_program_binary;
+		#endif
+
+		GLint length = 0;
+		if (supported) glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		resource_set(name, 0, length > 0 ? length : 0);
+	}
+
+	// Print tracked resources, totals and high-water marks
+	void resource_report() {
+		auto& r = g_resources;
+
+		cout << "Memory:" << endl;
+		for (auto& entry : r.usage) {
+			cout << "  + " << entry.first << endl;
+			cout << "    - CPU: " << resource_bytes_txt(entry.second.cpu_bytes) << endl;
+			cout << "    - GPU: " << resource_bytes_txt(entry.second.gpu_bytes) << endl;
+		}
+		cout << "  + Total" << endl;
+		cout << "    - CPU: " << resource_bytes_txt(r.cpu_total) << " (peak " << resource_bytes_txt(r.cpu_peak) << ")" << endl;
+		cout << "    - GPU: " << resource_bytes_txt(r.gpu_total) << " (peak " << resource_bytes_txt(r.gpu_peak) << ")" << endl;
+	}
+}
+
+#endif // __CUSTOM_RESOURCES__
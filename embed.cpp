@@ -0,0 +1,151 @@
+/******************************************************************************/
+
+/***********/
+/* Imports */
+/***********/
+
+/* STD */
+
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* Custom Imports */
+
+#include "custom/gl_load.cpp"      // Load OpenGL function pointers
+#include "custom/gl_shader.cpp"    // Compile/link OpenGL shaders
+#include "custom/model.cpp"        // Model loading and utils
+#include "custom/model_import.cpp" // Import OBJ/PLY models
+
+/******************************************************************************/
+
+/*************/
+/* Constants */
+/*************/
+
+// Assets are read from disk, never from a previous embedding
+#ifdef EMBED_ASSETS
+	#error "embed.cpp must be compiled without EMBED_ASSETS"
+#endif
+
+// Input/Output Constants
+#define ASSETS_OUT "custom/embedded_assets.cpp"
+
+// Models to embed
+vector<const char*> g_model_files = {
+	"models/sphere.tlst",
+	"models/cube.tlst",
+	"models/bunny.tlst"
+};
+
+// Shaders to embed
+vector<const char*> g_shader_files = {
+	"shaders/main/vertex_shader.glsl",
+	"shaders/main/fragment_shader.glsl"
+};
+
+/******************************************************************************/
+
+/*************************/
+/* Function Declarations */
+/*************************/
+
+string float_literal(GLfloat value);
+
+/******************************************************************************/
+
+int main() {
+	// Load models
+	vector<custom::Model> models;
+	for (auto filename : g_model_files) models.push_back(custom::model_load(filename));
+
+	ofstream out;
+	out.open(ASSETS_OUT);
+
+	if (!out) {
+		cerr << "Failed to open " << ASSETS_OUT << "." << endl;
+		return EXIT_FAILURE;
+	}
+
+	out << "// Embedded Models / Shaders" << endl;
+	out << "// Generated by embed.out, do not edit" << endl;
+	out << endl;
+	out << "#ifndef __CUSTOM_EMBEDDED_ASSETS__" << endl;
+	out << "#define __CUSTOM_EMBEDDED_ASSETS__" << endl;
+	out << endl;
+	out << "namespace custom {" << endl;
+
+	/* Model Data */
+
+	for (auto i = (size_t) 0; i < models.size(); i++) {
+		auto& v = models[i].vertices;
+		auto& t = models[i].triangles;
+
+		out << "\t// " << models[i].filename << endl;
+
+		out << "\tstatic const GLfloat embedded_vertices_" << i << "[] = {" << endl;
+		for (auto j = (size_t) 0; j < v.size() - 2; j += 3) {
+			out << "\t\t" << float_literal(v[j]) << ", " << float_literal(v[j + 1]) << ", " << float_literal(v[j + 2]) << "," << endl;
+		}
+		out << "\t};" << endl;
+
+		out << "\tstatic const GLint embedded_triangles_" << i << "[] = {" << endl;
+		for (auto j = (size_t) 0; j < t.size() - 2; j += 3) {
+			out << "\t\t" << t[j] << ", " << t[j + 1] << ", " << t[j + 2] << "," << endl;
+		}
+		out << "\t};" << endl;
+		out << endl;
+	}
+
+	/* Model Table */
+
+	out << "\tstatic const EmbeddedModel embedded_models[] = {" << endl;
+	for (auto i = (size_t) 0; i < models.size(); i++) {
+		auto& model = models[i];
+
+		out << "\t\t{ \"" << model.filename << "\", ";
+		out << model.vertex_count << ", " << model.triangle_count << ", ";
+		out << "embedded_vertices_" << i << ", embedded_triangles_" << i << ", ";
+		out << float_literal(model.lowest_vertex) << " }," << endl;
+	}
+	out << "\t};" << endl;
+	out << endl;
+
+	/* Shader Table */
+
+	out << "\tstatic const EmbeddedShader embedded_shaders[] = {" << endl;
+	for (auto filename : g_shader_files) {
+		auto code = custom::gl_load_shader_code(filename);
+		out << "\t\t{ \"" << filename << "\", R\"GLSL(" << code << ")GLSL\" }," << endl;
+		delete[] code;
+	}
+	out << "\t};" << endl;
+
+	out << "}" << endl;
+	out << endl;
+	out << "#endif // __CUSTOM_EMBEDDED_ASSETS__" << endl;
+
+	return EXIT_SUCCESS;
+}
+
+/******************************************************************************/
+
+// Print a float as a C++ literal that parses back to the exact same value
+string float_literal(GLfloat value) {
+	ostringstream literal;
+	literal.precision(numeric_limits<GLfloat>::max_digits10);
+	literal << value;
+
+	// Whole numbers are printed without a decimal point
+	auto txt = literal.str();
+	if (txt.find_first_of(".e") == string::npos) txt += ".0";
+
+	return txt + "f";
+}
+
+/******************************************************************************/
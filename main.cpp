@@ -12,12 +12,23 @@ using namespace std;
 
 /* Custom Imports */
 
-#include "custom/gl_load.cpp"    // Load OpenGL function pointers
-#include "custom/gl_debug.cpp"   // Enable OpenGL errors/warnings
-#include "custom/gl_shader.cpp"  // Compile/link OpenGL shaders
-#include "custom/model.cpp"      // Model loading and utils
-#include "custom/gl_helpers.cpp" // OpenGL helpers
-#include "custom/glfw.cpp"       // Handle windowing operations and keyboard/mouse events
+#include "custom/gl_load.cpp"       // Load OpenGL function pointers
+#include "custom/gl_debug.cpp"      // Enable OpenGL errors/warnings
+#include "custom/gl_shader.cpp"     // Compile/link OpenGL shaders
+#include "custom/model.cpp"         // Model loading and utils
+#include "custom/gl_helpers.cpp"    // OpenGL helpers
+#include "custom/glfw.cpp"          // Handle windowing operations and keyboard/mouse events
+#include "custom/gl_capture.cpp"    // Asynchronous frame capture
+#include "custom/resources.cpp"     // Resource memory accounting
+#include "custom/physics.cpp"       // Bouncing object simulation
+#include "custom/model_stream.cpp"  // Progressive loading of large models
+#include "custom/model_import.cpp"  // Import OBJ/PLY models
+#include "custom/input_log.cpp"     // Record/replay keyboard and mouse input
+#include "custom/frame_timings.cpp" // Per-frame timings
+
+#ifdef EMBED_ASSETS
+	#include "custom/embedded.cpp" // Models/shaders compiled into the binary
+#endif
 
 /* External */
 
@@ -41,21 +52,71 @@ using namespace std;
 #define V_SHADER "shaders/main/vertex_shader.glsl"
 #define F_SHADER "shaders/main/fragment_shader.glsl"
 
+// Model loader
+// Embedded models skip file I/O and parsing
+#ifdef EMBED_ASSETS
+	#define MODEL_LOAD custom::model_embedded_load
+#else
+	#define MODEL_LOAD custom::model_load
+#endif
+
 // Window constants
 #define WINDOW_WIDTH  800
 #define WINDOW_HEIGHT 800
 #define WINDOW_TITLE  "ZERO NO GATO"
 
+// Debug constants
+// Synchronous OpenGL messages are easier to trace but slow down every call
+#ifndef DEBUG_SYNCHRONOUS
+	#define DEBUG_SYNCHRONOUS 0
+#endif
+
+// Memory budgets in bytes, 0 means unlimited
+#ifndef MEMORY_BUDGET_CPU
+	#define MEMORY_BUDGET_CPU 0
+#endif
+#ifndef MEMORY_BUDGET_GPU
+	#define MEMORY_BUDGET_GPU 0
+#endif
+
+// Streaming constants
+// Compile with -DSTREAM_MODEL='"path/to/model.tlst"' to add a large model
+// that is uploaded STREAM_CHUNK vertices/triangles per frame while drawing
+#define STREAM_CHUNK 16384
+
+// Headless constants
+// Run in a hidden window for a fixed number of frames
+#ifndef HEADLESS
+	#define HEADLESS 0
+#endif
+#define HEADLESS_FRAMES 600
+
+// Capture constants
+// CAPTURE_OFF, CAPTURE_RAW or CAPTURE_PNG
+#ifndef CAPTURE
+	#define CAPTURE CAPTURE_OFF
+#endif
+#define CAPTURE_OUT "capture"
+
+// Input constants
+// -DINPUT_RECORD='"run.input"' records key/mouse events by frame number
+// -DINPUT_REPLAY='"run.input"' plays them back instead of live input,
+// and writes per-frame timings to REPLAY_TIMINGS
+#if defined(INPUT_RECORD) && defined(INPUT_REPLAY)
+	#error "INPUT_RECORD and INPUT_REPLAY cannot be used together"
+#endif
+#ifdef INPUT_REPLAY
+	#define REPLAY 1
+#else
+	#define REPLAY 0
+#endif
+#define REPLAY_TIMINGS "replay_timings.csv"
+
 // State constants
 #define STATE_PAUSE 0
 #define STATE_RUN   1
 #define STATE_RESET 2
 
-// Simulation constants
-#define GROUND         -1.00f
-#define HIT_FACTOR      0.85f
-#define REVERSE_FACTOR -1.00f
-
 /******************************************************************************/
 
 /********************/
@@ -65,12 +126,15 @@ using namespace std;
 // Current state
 int g_state = STATE_RESET;
 
-// Simulation variables
-float g_x_pos;
-float g_y_pos;
-float g_x_vel;
-float g_y_vel;
-float g_y_acc;
+// Start running right after a reset, since nobody can resume a headless run
+// Replays take this from their recording
+bool g_auto_run = HEADLESS;
+
+// Frames rendered so far
+long g_frame = 0;
+
+// Simulated object
+custom::Body g_body;
 
 // Color values
 int g_color_index = 0;
@@ -84,6 +148,15 @@ vector<glm::vec4> g_colors = {
 int g_model_index = 0;
 vector<custom::Model> g_models;
 
+// Large model being loaded progressively
+custom::ModelStream g_stream;
+
+// Recorded or replayed input
+custom::InputLog g_input;
+
+// Frame times of a replay
+custom::FrameTimings g_timings;
+
 // Possible polygon modes
 int g_mode_index = 0;
 vector<GLenum> g_modes = { GL_LINE, GL_FILL };
@@ -102,6 +175,8 @@ void win_resize_callback(GLFWwindow* window, int width, int height);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 
+void load_model(const char* filename);
+bool running(GLFWwindow* window);
 void update(custom::Model model);
 void reset(custom::Model model);
 void draw(custom::Model model);
@@ -113,6 +188,9 @@ int main() {
 	// Initialize GLFW
 	custom::glfw_init(OPEN_GL_MAJOR_VERSION, OPEN_GL_MINOR_VERSION);
 
+	// Hide window in headless mode
+	if (HEADLESS) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
 	// Create window
 	auto window = custom::glfw_create_window(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_TITLE);
 	glfwMakeContextCurrent(window);
@@ -121,56 +199,150 @@ int main() {
 	custom::gl_load();
 
 	// Enable OpenGL Errors / Warnings
-	custom::gl_debug_enable();
+	custom::gl_debug_enable(DEBUG_SYNCHRONOUS);
 
 	// Callbacks
 	glfwSetFramebufferSizeCallback(window, win_resize_callback);
-	glfwSetKeyCallback(window, key_callback);
-	glfwSetMouseButtonCallback(window, mouse_button_callback);
+	// Replays ignore live input
+	if (!REPLAY) {
+		glfwSetKeyCallback(window, key_callback);
+		glfwSetMouseButtonCallback(window, mouse_button_callback);
+	}
+
+	// Track memory usage of programs and models
+	custom::resource_set_budget(MEMORY_BUDGET_CPU, MEMORY_BUDGET_GPU);
 
 	// Load program
 	program = custom::gl_make_program(V_SHADER, F_SHADER);
 	glUseProgram(program);
+	custom::resource_track_program("program", program);
+
+	// Initial viewport and projection
+	int fb_width, fb_height;
+	glfwGetFramebufferSize(window, &fb_width, &fb_height);
+	win_resize_callback(window, fb_width, fb_height);
+
+	// Do not wait for vertical sync when nobody is watching or when
+	// replay frame times are measured
+	if (HEADLESS || REPLAY) glfwSwapInterval(0);
 
 	// Load models
-	g_models.push_back(custom::model_tlst_load("models/sphere.tlst"));
-	g_models.push_back(custom::model_tlst_load("models/cube.tlst"));
-	g_models.push_back(custom::model_tlst_load("models/bunny.tlst"));
+	// CPU copies are tracked as soon as they exist, exceeding the budget is fatal
+	load_model("models/sphere.tlst");
+	load_model("models/cube.tlst");
+	load_model("models/bunny.tlst");
 
 	// Put model data in buffers
 	for (auto& model : g_models) {
+		// Check the GPU budget before allocating anything
+		auto gpu_bytes = custom::model_gpu_bytes(model.vertex_count, model.triangle_count);
+		if (!custom::resource_fits(0, gpu_bytes)) {
+			cerr << "Model " << model.filename << " does not fit in the GPU memory budget." << endl;
+			exit(EXIT_FAILURE);
+		}
+
 		glGenVertexArrays(1, &model.VAO);  
 		glGenBuffers(1, &model.VBO); 
 		glGenBuffers(1, &model.EBO);
 
 		glBindVertexArray(model.VAO);
 
-		glBindBuffer(GL_ARRAY_BUFFER, model.VBO);
-		custom::glBufferDataV(GL_ARRAY_BUFFER, model.vertices, GL_STATIC_DRAW);
+		#ifdef EMBED_ASSETS
+			// Upload directly from read-only data
+			auto asset = custom::embedded_model_find(model.filename.c_str());
+
+			glBindBuffer(GL_ARRAY_BUFFER, model.VBO);
+			custom::glBufferDataA(GL_ARRAY_BUFFER, asset->vertices, model.vertex_count * VERTEX_3D_COMPONENTS, GL_STATIC_DRAW);
+
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model.EBO);
+			custom::glBufferDataA(GL_ELEMENT_ARRAY_BUFFER, asset->triangles, model.triangle_count * TRIANGLE_POINTS, GL_STATIC_DRAW);
+		#else
+			glBindBuffer(GL_ARRAY_BUFFER, model.VBO);
+			custom::glBufferDataV(GL_ARRAY_BUFFER, model.vertices, GL_STATIC_DRAW);
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model.EBO);
-		custom::glBufferDataV(GL_ELEMENT_ARRAY_BUFFER, model.triangles, GL_STATIC_DRAW);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model.EBO);
+			custom::glBufferDataV(GL_ELEMENT_ARRAY_BUFFER, model.triangles, GL_STATIC_DRAW);
+		#endif
 
 		glVertexAttribPointer(0, VERTEX_3D_COMPONENTS, GL_FLOAT, GL_TRUE, 0, (void*) 0);
 		glEnableVertexAttribArray(0);
+
+		// The GPU has the data now, CPU copies only count towards the peak
+		custom::resource_track_model(model);
+		custom::model_free_cpu(model);
+		custom::resource_track_model(model);
 	}
 
+	// Allocate GPU storage for the streamed model, data arrives every frame
+	#ifdef STREAM_MODEL
+		g_models.push_back(custom::model_stream_open(STREAM_MODEL, g_stream, STREAM_CHUNK));
+		custom::resource_set(
+			STREAM_MODEL,
+			custom::model_stream_cpu_bytes(g_stream),
+			custom::model_gpu_bytes(g_stream.vertex_count, g_stream.triangle_count)
+		);
+	#endif
+
+	// Start frame capture
+	custom::Capture* capture = NULL;
+	if (CAPTURE != CAPTURE_OFF) capture = custom::gl_capture_start(CAPTURE, fb_width, fb_height, CAPTURE_OUT);
+
+	// Start recording or load recorded input
+	#ifdef INPUT_RECORD
+		custom::input_record_start(g_input, INPUT_RECORD, HEADLESS);
+	#endif
+	#ifdef INPUT_REPLAY
+		custom::input_replay_load(g_input, INPUT_REPLAY);
+		g_auto_run = g_input.headless;
+		custom::frame_timings_tick(g_timings);
+	#endif
+
 	// Render loop
-	while(!glfwWindowShouldClose(window)) {
+	while(running(window)) {
+		#ifdef STREAM_MODEL
+			if (!g_stream.done && custom::model_stream_step(g_stream, g_models.back())) {
+				// Chunk buffers were released, only GPU storage remains
+				custom::resource_set(
+					STREAM_MODEL,
+					custom::model_stream_cpu_bytes(g_stream),
+					custom::model_gpu_bytes(g_stream.vertex_count, g_stream.triangle_count)
+				);
+			}
+		#endif
+
 		auto model = g_models[g_model_index % g_models.size()];
 		if (g_state != STATE_PAUSE) {
 			if (g_state == STATE_RUN) {
 				update(model);
 			} else {
 				reset(model);
-				g_state = STATE_PAUSE;
+				g_state = g_auto_run ? STATE_RUN : STATE_PAUSE;
 			}
 		}
 		draw(model);
+		if (capture != NULL) custom::gl_capture_frame(capture);
 		glfwSwapBuffers(window);
 		glfwPollEvents();
+		if (REPLAY) {
+			custom::input_replay_frame(g_input, g_frame, window, key_callback, mouse_button_callback);
+			custom::frame_timings_tick(g_timings);
+		}
+		g_frame++;
 	}
 
+	// Finish recording, report replay timings
+	custom::input_record_stop(g_input, g_frame);
+	if (REPLAY) custom::frame_timings_report(g_timings, REPLAY_TIMINGS);
+
+	// Write remaining captured frames
+	if (capture != NULL) custom::gl_capture_stop(capture);
+
+	// Print pending OpenGL messages
+	custom::gl_debug_disable();
+
+	// Print memory usage
+	custom::resource_report();
+
 	// Terminate
 	glfwTerminate();
 	return EXIT_SUCCESS;
@@ -184,9 +356,11 @@ int main() {
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
 	if (action != GLFW_PRESS) return;
+	custom::input_record(g_input, g_frame, INPUT_KEY, key, action);
 
 	// Exit on Q or ESCAPE
-	if (key == GLFW_KEY_Q || key == GLFW_KEY_ESCAPE) exit(EXIT_SUCCESS);
+	// Leave the render loop so pending work is finished
+	if (key == GLFW_KEY_Q || key == GLFW_KEY_ESCAPE) glfwSetWindowShouldClose(window, GLFW_TRUE);
 	// Pause/resume on SPACE
 	else if (key == GLFW_KEY_SPACE) g_state = g_state == STATE_RUN ? STATE_PAUSE : STATE_RUN;
 	// Reset position on i
@@ -195,10 +369,13 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 	else if (key == GLFW_KEY_C) g_color_index++;
 	// Print help to standard output on h
 	else if (key == GLFW_KEY_H) print_help();
+	// Print memory usage to standard output on m
+	else if (key == GLFW_KEY_M) custom::resource_report();
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
 	if (action != GLFW_PRESS) return;
+	custom::input_record(g_input, g_frame, INPUT_MOUSE, button, action);
 
 	// Change 3D model on right-click
 	if (button == GLFW_MOUSE_BUTTON_RIGHT) g_model_index++;
@@ -225,22 +402,25 @@ void win_resize_callback(GLFWwindow* window, int width, int height) {
 
 /******************************************************************************/
 
-// Update object in the simulation
-void update(custom::Model model) {
-	g_y_vel += g_y_acc;
+// Load a model and track its CPU copies
+void load_model(const char* filename) {
+	g_models.push_back(MODEL_LOAD(filename));
+	custom::resource_track_model_cpu(g_models.back());
+}
 
-	g_x_pos += g_x_vel;
-	g_y_pos += g_y_vel;
+// Check whether the render loop should continue
+bool running(GLFWwindow* window) {
+	if (glfwWindowShouldClose(window)) return false;
 
-	auto transform = glm::mat4(1.0f);
-	transform = glm::translate(transform, glm::vec3(g_x_pos, g_y_pos, 0.0f));
+	// Replays stop where the recording stopped
+	if (REPLAY) return !custom::input_replay_done(g_input, g_frame);
 
-	auto new_min = transform * glm::vec4(1.0f, model.lowest_vertex, 1.0f, 1.0f);
+	return !HEADLESS || g_frame < HEADLESS_FRAMES;
+}
 
-	if (new_min.y < GROUND) {
-		g_y_vel *= REVERSE_FACTOR * HIT_FACTOR;
-		g_y_pos = GROUND - model.lowest_vertex;
-	}
+// Update object in the simulation
+void update(custom::Model model) {
+	auto transform = custom::body_step(g_body, model.lowest_vertex);
 
 	auto transform_loc = glGetUniformLocation(program, "transform");
 	glUniformMatrix4fv(transform_loc, 1, GL_FALSE, glm::value_ptr(transform));
@@ -248,11 +428,7 @@ void update(custom::Model model) {
 
 // Reset object to initial position
 void reset(custom::Model model) {
-	g_x_pos = 0;
-	g_y_pos = 0;
-	g_x_vel = 0.005f;
-	g_y_vel = 0;
-	g_y_acc = -0.00098f;
+	custom::body_reset(g_body);
 
 	auto transform = glm::mat4(1.0f); // Identity
 
@@ -285,6 +461,7 @@ void print_help() {
 	cout << "    - i           -> Reset Simulation Position" << endl;
 	cout << "    - c           -> Change Color" << endl;
 	cout << "    - h           -> Print This Help Message" << endl;
+	cout << "    - m           -> Print Memory Usage" << endl;
 	cout << "  + Mouse Bindings:" << endl;
 	cout << "    - RIGHT-CLICK -> Change 3D Model" << endl;
 	cout << "    - LEFT-CLICK  -> Change Polygon Mode" << endl;